@@ -0,0 +1,262 @@
+#ifndef TDC_MAPPING_H
+#define TDC_MAPPING_H
+
+/** Trigger, discriminator and v1495 board tables and the TDC channel mapping,
+    shared by timeCalib and TriggerAna **/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <fstream>
+
+#include <TString.h>
+#include <TObjArray.h>
+
+/** Trig numbers **/
+#define N_TRIG 12  
+#define N_BOARD 5 
+#define N_CH 96 
+#define N_DISC 6 // (5 discriminators +  no discriminator)
+#define N_STATION 4
+
+/** v1495 boardID range covered by the boardID -> board index lookup **/
+#define MAX_BOARD_ID 0x1000
+
+/** Hodoscope half (T, B) of a channel, from its name in the mapping file **/
+#define HALF_TOP 0
+#define HALF_BOTTOM 1
+#define N_HALF 2
+
+using namespace std;
+
+
+typedef tuple<int, string, string> tuple_info;
+typedef tuple<int, string, string, string, string> tuple_v1495;
+
+const tuple_info info_trig[N_TRIG] =
+  {
+   tuple_info(0, "FPGA1", "ST 2 & 4"),
+   tuple_info(1, "FPGA2", "ST 2T & 4T"),
+   tuple_info(2, "FPGA3", "ST 2T & 4B"),
+   tuple_info(3, "FPGA4", "ST 2B & 4T"),
+   //tuple_info(4, "FPGA5", "NIM ST 2 & 4"), // ~run 1501
+   tuple_info(4, "FPGA5", "ST 2B & 4B"), // run 1502~  
+   tuple_info(5, "NIM1", "ST 1 & 2 & 3 & 4"),
+   tuple_info(6, "NIM2", "ST 1 & 2"),
+   tuple_info(7, "NIM3", "Random"),
+   // tuple_info(8, "NIM4", "ST 2 & 3"), // ~run 1501
+   tuple_info(8, "NIM4", "ST 2 & 4"), // run 1502~   
+   tuple_info(9, "NIM5", "Flush"),
+   tuple_info(10, "BOS", "Begin of spill"),
+   tuple_info(11, "EOS", "End of spill")   
+  };
+
+/** Hodoscope Discriminator **/
+const tuple_info info_disc[N_DISC] =
+  {
+   tuple_info(0, "ST1" , "ST1 H5-19"),
+   tuple_info(1, "ST2" , "ST2 H1-16"),
+   tuple_info(2, "ST3" , "ST3 H1-16"),
+   tuple_info(3, "ST4a", "ST4 H1-8" ),
+   tuple_info(4, "ST4b", "ST4 H9-16"),
+   tuple_info(5, "NotHodo", "G port or Empty channel")
+  };
+
+
+/** delay and mapping files
+
+    up-to-date timing files are under
+    /home/e1039daq/noahKnowsBest/vme_workdir
+
+    mapping files from redmine
+**/
+const tuple_v1495 info_board[N_BOARD] =
+  {
+   tuple_v1495(0, "420", "XT Lv-A", "Mapping/420mapping.txt", "Timing/time_0.txt"),
+   tuple_v1495(1, "430", "XB Lv-A", "Mapping/430mapping.txt", "Timing/time_1.txt"),
+   tuple_v1495(2, "460", "XT Lv-B", "Mapping/460mapping.txt", "Timing/time_2.txt"),
+   tuple_v1495(3, "470", "XB Lv-B", "Mapping/470mapping.txt", "Timing/time_3.txt"),
+   tuple_v1495(4, "480", "XT Lv-C", "Mapping/480mapping.txt", "Timing/time_4.txt")
+  };
+
+/** TDC mapping, loaded once from the mapping files into small integer tables
+    indexed by [iboard][ich], so that decoding a hit is a couple of array lookups **/
+struct TdcMap
+{
+  signed char   board_index[MAX_BOARD_ID]; // v1495 boardID -> iboard, -1 for unknown board
+  unsigned      board_id[N_BOARD]; // iboard -> v1495 boardID
+
+  unsigned char ch     [N_BOARD][N_CH]; // v1495 TDC channel, as written in the mapping file
+  unsigned char disc   [N_BOARD][N_CH]; // discriminator module, index of info_disc
+  unsigned char station[N_BOARD][N_CH]; // hodoscope station, 5-7 for G port and empty channels
+  char          port   [N_BOARD][N_CH]; // v1495 port name (A,B,C,D,E,F,G), half port share a ribbon cable from discriminator
+  unsigned char port_ch[N_BOARD][N_CH]; // channel in the v1495 port
+
+  // hodoscope paddle from the name, e.g. H4Tu08 = station 4, top, paddle 8 (index 7), upstream PMT
+  // hodo_station is 0 for G port and empty channels
+  unsigned char hodo_station[N_BOARD][N_CH];
+  unsigned char hodo_half   [N_BOARD][N_CH];
+  unsigned char hodo_element[N_BOARD][N_CH];
+
+  // only for the mapping dump, never used in the event loop
+  string name[N_BOARD][N_CH]; // whole name for cross check
+  string vhdl[N_BOARD][N_CH]; // vhdl name. not used for now
+};
+
+
+/** read mapping files under "dir" into "map", station and discriminator are fixed by the TDC channel range **/
+inline void load_tdc_map(TdcMap& map, const string& dir="")
+{
+  memset(map.board_index, -1, sizeof(map.board_index));
+  
+  for(int iboard=0; iboard<N_BOARD; iboard++)
+    {
+      map.board_id[iboard] = stoul( get<1>(info_board[iboard]), NULL, 16 );
+      map.board_index[ map.board_id[iboard] ] = iboard;
+      
+      ifstream ifs(dir + get<3>(info_board[iboard]));            
+
+      TString line_chmap;
+      line_chmap.ReadLine(ifs);
+
+      
+      for(int ich=0; ich<N_CH; ich++)
+        {
+          line_chmap.ReadLine(ifs);
+
+          TObjArray * tempArray = line_chmap.Tokenize(",");
+
+          string port = tempArray->At(2)->GetName();
+
+          map.ch     [iboard][ich] = stoi( tempArray->At(0)->GetName() );
+          map.name   [iboard][ich] = tempArray->At(1)->GetName();
+          map.port   [iboard][ich] = port[0];
+          map.port_ch[iboard][ich] = stoi( port.substr(1) );
+          map.vhdl   [iboard][ich] = tempArray->At(3)->GetName();
+
+          delete tempArray;
+
+          int  hodo_station = 0;
+          char hodo_half    = ' ';
+          int  hodo_element = 0;
+          char hodo_pmt     = ' ';
+
+          const char* name = map.name[iboard][ich].c_str();
+
+          if( sscanf(name, "H%1d%c%2d", &hodo_station, &hodo_half, &hodo_element)!=3 &&
+              sscanf(name, "H%1d%c%c%2d", &hodo_station, &hodo_half, &hodo_pmt, &hodo_element)!=4 )
+            {
+              hodo_station = 0;
+              hodo_element = 1;
+            }
+
+          map.hodo_station[iboard][ich] = hodo_station;
+          map.hodo_half   [iboard][ich] = ( hodo_half=='B' ) ? HALF_BOTTOM : HALF_TOP;
+          map.hodo_element[iboard][ich] = hodo_element-1;
+          
+         
+          if( ich < 16 )
+            {
+              map.disc   [iboard][ich] = 3;
+              map.station[iboard][ich] = 4;
+            }
+          else if( ich < 32 )
+            {
+              map.disc   [iboard][ich] = 4;
+              map.station[iboard][ich] = 4;
+            }
+          else if( ich < 48 )
+            {
+              map.disc   [iboard][ich] = 1;
+              map.station[iboard][ich] = 2;
+            }
+          else if( ich < 64 )
+            {
+              map.disc   [iboard][ich] = 2;
+              map.station[iboard][ich] = 3;
+            }
+          else if( ich > 65 && ich <80 )
+            {              
+              map.disc   [iboard][ich] = 0;
+              map.station[iboard][ich] = 1;
+            }
+          else if( ich == 64 )
+            {              
+              map.disc   [iboard][ich] = 5;
+              map.station[iboard][ich] = 5;
+            }
+          else if( ich == 65 )
+            {              
+              map.disc   [iboard][ich] = 5;
+              map.station[iboard][ich] = 6;
+            }
+          else
+            {              
+              map.disc   [iboard][ich] = 5;
+              map.station[iboard][ich] = 7;
+            }
+
+          if( ich!= map.ch[iboard][ich] )
+            cout << "scary bug" << endl;
+        }
+    }
+}
+
+
+/** Reference time for delay adjustment: new delay = peak - TIME_REF + old delay (TDC unit) **/
+#define TIME_REF 650
+
+/** channels whose timing is calibrated: hodoscope channels of Lv-A/B boards **/
+inline bool calib_channel(const TdcMap& map, int iboard, int ich)
+{
+  return map.disc[iboard][ich]<5 && iboard<4;
+}
+
+
+/** read the delay file (Timing, "NNN:fXX" per channel) of board "iboard" under "dir" into "ch" and "delay",
+    false if the file cannot be read **/
+inline bool read_delays(int iboard, int ch[N_CH], int delay[N_CH], const string& dir="")
+{
+  ifstream ifs(dir + get<4>(info_board[iboard]));
+
+  if( !ifs )
+    return false;
+
+  for(int ich=0; ich<N_CH; ich++)
+    {
+      char line_delay[255];
+      ifs.getline(line_delay,255);
+
+      ch[ich] = ich;
+      delay[ich] = 0;
+
+      sscanf(line_delay,"%d:f%x",&ch[ich],&delay[ich]);
+    }
+
+  return true;
+}
+
+
+inline void print_tdc_map(const TdcMap& map)
+{
+  cout << "TDC mapping check: board, channel, name, station/else, disc, v1495port, vhdl " << endl;
+  
+  for(int iboard=0; iboard<N_BOARD; iboard++)
+    {
+      for(int ich=0; ich<N_CH; ich++)
+        {
+          cout << hex << map.board_id[iboard] << dec << "\t"
+               << Form("%02d", map.ch[iboard][ich]) << "\t"
+               << map.name[iboard][ich] << "\t"
+               << int(map.station[iboard][ich]) << "\t"
+               << int(map.disc[iboard][ich]) << "\t"
+               << Form("%c%02d", map.port[iboard][ich], map.port_ch[iboard][ich]) << "\t"
+               << map.vhdl[iboard][ich] << endl;          
+        }
+     }
+}
+
+
+#endif